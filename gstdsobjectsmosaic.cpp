@@ -43,7 +43,8 @@ enum
   PROP_GPU_DEVICE_ID,
   PROP_MIN_CONFIDENCE,
   PROP_MOSAIC_SIZE,
-  PROP_CLASS_IDS
+  PROP_CLASS_IDS,
+  PROP_CLASS_REGIONS
 };
 
 #define CHECK_NVDS_MEMORY_AND_GPUID(object, surface)  \
@@ -112,6 +113,7 @@ static void gst_dsom_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
 static void gst_dsom_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec);
+static void gst_dsom_finalize (GObject * object);
 
 static gboolean gst_dsom_set_caps (GstBaseTransform * btrans,
     GstCaps * incaps, GstCaps * outcaps);
@@ -142,6 +144,7 @@ gst_dsom_class_init (GstDsObjectsMosaicClass * klass)
   /* Overide base class functions */
   gobject_class->set_property = GST_DEBUG_FUNCPTR (gst_dsom_set_property);
   gobject_class->get_property = GST_DEBUG_FUNCPTR (gst_dsom_get_property);
+  gobject_class->finalize = GST_DEBUG_FUNCPTR (gst_dsom_finalize);
 
   gstbasetransform_class->set_caps = GST_DEBUG_FUNCPTR (gst_dsom_set_caps);
   gstbasetransform_class->start = GST_DEBUG_FUNCPTR (gst_dsom_start);
@@ -187,6 +190,16 @@ gst_dsom_class_init (GstDsObjectsMosaicClass * klass)
           "An array of colon-separated class ids for which blur is applied",
           "", (GParamFlags)
           (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
+
+  g_object_class_install_property (gobject_class, PROP_CLASS_REGIONS,
+      g_param_spec_string ("class-regions",
+          "class regions",
+          "An array of semicolon-separated sub-regions to be blurred instead of"
+          " the whole object, each given as class_id:left,top,width,height in"
+          " fractions of the object box (e.g. 0:0.2,0,0.6,0.22). Only applies"
+          " to classes also listed in class-ids",
+          "", (GParamFlags)
+          (G_PARAM_READWRITE | G_PARAM_STATIC_STRINGS)));
   
   /* Set sink and src pad capabilities */
   gst_element_class_add_pad_template (gstelement_class,
@@ -219,6 +232,7 @@ gst_dsom_init (GstDsObjectsMosaic * dsom)
   dsom->gpu_id = DEFAULT_GPU_ID;
   dsom->mosaic_size = DEFAULT_MOSAIC_SIZE;
   dsom->class_ids = new std::set<uint>;
+  dsom->class_regions = new std::map<uint, std::vector<DsomRegion>>;
 
   /* This quark is required to identify NvDsMeta when iterating through
    * the buffer metadatas */
@@ -249,13 +263,43 @@ gst_dsom_set_property (GObject * object, guint prop_id,
     case PROP_CLASS_IDS:
     {
       std::stringstream str(g_value_get_string(value));
-      dsom->class_ids->clear();
+      std::set<uint> *class_ids = new std::set<uint>;
       while(str.peek() != EOF) {
         gint class_id;
         str >> class_id;
-        dsom->class_ids->insert(class_id);
+        class_ids->insert(class_id);
         str.get();
       }
+      /* Swap in the new set so the streaming thread never sees it half
+       * built. */
+      GST_OBJECT_LOCK (dsom);
+      std::swap (dsom->class_ids, class_ids);
+      GST_OBJECT_UNLOCK (dsom);
+      delete class_ids;
+    }
+      break;
+    case PROP_CLASS_REGIONS:
+    {
+      std::stringstream str(g_value_get_string(value));
+      std::string entry;
+      std::map<uint, std::vector<DsomRegion>> *class_regions =
+          new std::map<uint, std::vector<DsomRegion>>;
+      while(std::getline(str, entry, ';')) {
+        guint class_id;
+        DsomRegion region;
+        if (entry.empty())
+          continue;
+        if (!dsom_parse_class_region (entry.c_str(), &class_id, &region)) {
+          GST_WARNING_OBJECT (dsom, "Ignoring invalid class region '%s'",
+              entry.c_str());
+          continue;
+        }
+        (*class_regions)[class_id].push_back(region);
+      }
+      GST_OBJECT_LOCK (dsom);
+      std::swap (dsom->class_regions, class_regions);
+      GST_OBJECT_UNLOCK (dsom);
+      delete class_regions;
     }
       break;
     default:
@@ -289,8 +333,22 @@ gst_dsom_get_property (GObject * object, guint prop_id,
     case PROP_CLASS_IDS:
     {
       std::stringstream str;
+      GST_OBJECT_LOCK (dsom);
       for(const auto id : *dsom->class_ids)
         str << id << ";";
+      GST_OBJECT_UNLOCK (dsom);
+      g_value_set_string (value, str.str ().c_str ());
+    }
+      break;
+    case PROP_CLASS_REGIONS:
+    {
+      std::stringstream str;
+      GST_OBJECT_LOCK (dsom);
+      for(const auto &regions : *dsom->class_regions)
+        for(const auto &region : regions.second)
+          str << regions.first << ":" << region.left << "," << region.top
+              << "," << region.width << "," << region.height << ";";
+      GST_OBJECT_UNLOCK (dsom);
       g_value_set_string (value, str.str ().c_str ());
     }
       break;
@@ -354,9 +412,21 @@ gst_dsom_stop (GstBaseTransform * btrans)
     cudaStreamDestroy (dsom->cuda_stream);
   dsom->cuda_stream = NULL;
 
+  return TRUE;
+}
+
+/**
+ * Free the resources allocated in gst_dsom_init
+ */
+static void
+gst_dsom_finalize (GObject * object)
+{
+  GstDsObjectsMosaic *dsom = GST_DSOM (object);
+
   delete dsom->class_ids;
+  delete dsom->class_regions;
 
-  return TRUE;
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 /**
@@ -475,6 +545,7 @@ gst_dsom_transform_ip (GstBaseTransform * btrans, GstBuffer * inbuf)
       status = cuCtxSynchronize();
 
       cv::Size ksize;
+      std::vector<DsomRegion> blur_rects;
       cv::cuda::GpuMat in_mat(surface->surfaceList[frame_meta->batch_id].planeParams.height[0],
                   surface->surfaceList[frame_meta->batch_id].planeParams.width[0],
                   CV_8UC4, eglFrame.frame.pPitch[0]);
@@ -484,31 +555,67 @@ gst_dsom_transform_ip (GstBaseTransform * btrans, GstBuffer * inbuf)
       {
         obj_meta = (NvDsObjectMeta *) (l_obj->data);
 
-        /* Skip too small objects since they cause resizing issues. */
-        if (obj_meta->rect_params.width < dsom->mosaic_size*2 ||
-            obj_meta->rect_params.height < dsom->mosaic_size*2 ||
-            obj_meta->confidence < dsom->min_confidence )
+        if (obj_meta->confidence < dsom->min_confidence)
           continue;
 
+        DsomRegion box = { obj_meta->rect_params.left,
+            obj_meta->rect_params.top, obj_meta->rect_params.width,
+            obj_meta->rect_params.height };
+
+        /* Blur only the configured sub-regions of the box if any, otherwise
+         * the whole box. */
+        blur_rects.clear();
+        GST_OBJECT_LOCK (dsom);
         /* apply blur only for objects with given class ids */
         auto id_itr = dsom->class_ids->find(obj_meta->class_id);
-        if ( id_itr == dsom->class_ids->end() || *id_itr != obj_meta->class_id)
-          continue;
-
-        /* Calculate scaling destination size. */
-        ksize = cv::Size (obj_meta->rect_params.width / dsom->mosaic_size,
-                          obj_meta->rect_params.height / dsom->mosaic_size);
+        gboolean selected = id_itr != dsom->class_ids->end() &&
+            *id_itr == obj_meta->class_id;
+        auto region_itr = dsom->class_regions->find(obj_meta->class_id);
+        if (selected && region_itr != dsom->class_regions->end()) {
+          for (const auto &region : region_itr->second) {
+            DsomRegion rect = dsom_region_in_box (region, box);
+            /* Pixelate the whole box rather than leave a region unblurred
+             * when the box cannot hold a region of two mosaic squares. */
+            if (!dsom_region_fit (&rect, box, dsom->mosaic_size)) {
+              blur_rects.clear();
+              break;
+            }
+            blur_rects.push_back(rect);
+          }
+        }
+        GST_OBJECT_UNLOCK (dsom);
 
-        if (blur_objects (dsom, frame_meta->batch_id,
-          &obj_meta->rect_params, in_mat, ksize) != GST_FLOW_OK) {
-        /* Error in blurring, skip processing on object. */
-          GST_ELEMENT_ERROR (dsom, STREAM, FAILED,
-          ("blurring the object failed"), (NULL));
-          if (NvBufSurfaceUnMapEglImage (surface, frame_meta->batch_id) != 0){
+        if (!selected)
+          continue;
+        if (blur_rects.empty())
+          blur_rects.push_back(box);
+
+        for (const auto &rect : blur_rects) {
+          /* Skip too small objects since they cause resizing issues. */
+          if (dsom_region_too_small (rect, dsom->mosaic_size))
+            continue;
+
+          NvOSD_RectParams rect_params = obj_meta->rect_params;
+          rect_params.left = rect.left;
+          rect_params.top = rect.top;
+          rect_params.width = rect.width;
+          rect_params.height = rect.height;
+
+          /* Calculate scaling destination size. */
+          ksize = cv::Size (rect_params.width / dsom->mosaic_size,
+                            rect_params.height / dsom->mosaic_size);
+
+          if (blur_objects (dsom, frame_meta->batch_id,
+            &rect_params, in_mat, ksize) != GST_FLOW_OK) {
+          /* Error in blurring, skip processing on object. */
             GST_ELEMENT_ERROR (dsom, STREAM, FAILED,
-              ("%s:buffer unmap failed", __func__), (NULL));
+            ("blurring the object failed"), (NULL));
+            if (NvBufSurfaceUnMapEglImage (surface, frame_meta->batch_id) != 0){
+              GST_ELEMENT_ERROR (dsom, STREAM, FAILED,
+                ("%s:buffer unmap failed", __func__), (NULL));
+            }
+            return GST_FLOW_ERROR;
           }
-          return GST_FLOW_ERROR;
         }
       }
 
@@ -41,10 +41,13 @@
 #include <cuda.h>
 #include <cuda_runtime.h>
 #include <cudaEGL.h>
+#include <map>
 #include <set>
+#include <vector>
 #include "nvbufsurface.h"
 #include "gst-nvquery.h"
 #include "gstnvdsmeta.h"
+#include "gstdsobjectsmosaic_region.h"
 
 /* Package and library details required for plugin_init */
 #define PACKAGE "dsobjectsmosaic"
@@ -101,8 +104,12 @@ struct _GstDsObjectsMosaic
   // size of each square of mosaic
   gint mosaic_size;
 
-  // class ids for which blur is applied
+  // class ids for which blur is applied, guarded by the object lock
   std::set<uint> *class_ids;
+
+  // fractional sub-regions of the box to be blurred, keyed by class id,
+  // guarded by the object lock
+  std::map<uint, std::vector<DsomRegion>> *class_regions;
 };
 
 // Boiler plate stuff
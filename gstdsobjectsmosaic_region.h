@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2022, seieric
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.  IN NO EVENT SHALL
+ * THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+ * FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+ * DEALINGS IN THE SOFTWARE.
+ */
+
+#ifndef __GST_DSOM_REGION_H__
+#define __GST_DSOM_REGION_H__
+
+/* Helpers for the class-regions property. They depend on GLib only, not on
+ * GStreamer, CUDA or DeepStream, so they can be compiled and checked on their
+ * own. */
+
+#include <errno.h>
+#include <cmath>
+#include <glib.h>
+
+// rectangle in fractions of an object box, or in pixels of a frame
+struct DsomRegion
+{
+  float left;
+  float top;
+  float width;
+  float height;
+};
+
+/* Parse a single "class_id:left,top,width,height" entry. Numbers are parsed
+ * in the C locale. Returns false unless the whole entry is consumed, the class
+ * id is a decimal guint and the region is a finite, non-empty sub-rectangle of
+ * the unit box. */
+static inline bool
+dsom_parse_class_region (const char *entry, unsigned int *class_id,
+    DsomRegion *region)
+{
+  gchar *end = NULL;
+  guint64 id;
+  gdouble values[4];
+
+  if (!g_ascii_isdigit (entry[0]))
+    return false;
+  errno = 0;
+  id = g_ascii_strtoull (entry, &end, 10);
+  if (errno != 0 || id > G_MAXUINT || *end != ':')
+    return false;
+
+  for (int i = 0; i < 4; i++) {
+    const gchar *start = end + 1;
+    errno = 0;
+    values[i] = g_ascii_strtod (start, &end);
+    if (end == start || errno != 0 || *end != (i < 3 ? ',' : '\0'))
+      return false;
+  }
+
+  /* Written in positive form so that NaN fails every comparison. */
+  if (!(std::isfinite (values[0]) && std::isfinite (values[1]) &&
+          std::isfinite (values[2]) && std::isfinite (values[3]) &&
+          values[0] >= 0 && values[1] >= 0 && values[2] > 0 && values[3] > 0 &&
+          values[0] + values[2] <= 1 && values[1] + values[3] <= 1))
+    return false;
+
+  *class_id = id;
+  *region = DsomRegion { (float) values[0], (float) values[1],
+      (float) values[2], (float) values[3] };
+  return true;
+}
+
+/* Map a fractional region onto an object box given in pixels. */
+static inline DsomRegion
+dsom_region_in_box (const DsomRegion &region, const DsomRegion &box)
+{
+  return DsomRegion {
+    box.left + region.left * box.width,
+    box.top + region.top * box.height,
+    region.width * box.width,
+    region.height * box.height
+  };
+}
+
+/* Regions smaller than two mosaic squares cause resizing issues. */
+static inline bool
+dsom_region_too_small (const DsomRegion &rect, int mosaic_size)
+{
+  return rect.width < mosaic_size * 2 || rect.height < mosaic_size * 2;
+}
+
+/* Grow one side of a region to at least min_size around its centre, then
+ * shift it back inside [box_start, box_start + box_size]. */
+static inline bool
+dsom_region_grow_side (float *start, float *size, float box_start,
+    float box_size, float min_size)
+{
+  if (*size >= min_size)
+    return true;
+  if (box_size < min_size)
+    return false;
+
+  *start += (*size - min_size) / 2;
+  *size = min_size;
+  if (*start < box_start)
+    *start = box_start;
+  if (*start + *size > box_start + box_size)
+    *start = box_start + box_size - *size;
+  return true;
+}
+
+/* Make a region in pixels blurrable: grow it to at least two mosaic squares
+ * inside the box, and round it outward to whole pixels so that no fractional
+ * edge is left unblurred, clamped to the box as cv::Rect would truncate it.
+ * Returns false when the box itself is too small to hold such a region. */
+static inline bool
+dsom_region_fit (DsomRegion *rect, const DsomRegion &box, int mosaic_size)
+{
+  float min_size = mosaic_size * 2;
+  float box_left = std::floor (box.left);
+  float box_top = std::floor (box.top);
+  float box_right = std::floor (box.left + box.width);
+  float box_bottom = std::floor (box.top + box.height);
+  float left, top, right, bottom;
+
+  if (!dsom_region_grow_side (&rect->left, &rect->width, box_left,
+          box_right - box_left, min_size) ||
+      !dsom_region_grow_side (&rect->top, &rect->height, box_top,
+          box_bottom - box_top, min_size))
+    return false;
+
+  left = std::fmax (std::floor (rect->left), box_left);
+  top = std::fmax (std::floor (rect->top), box_top);
+  right = std::fmin (std::ceil (rect->left + rect->width), box_right);
+  bottom = std::fmin (std::ceil (rect->top + rect->height), box_bottom);
+  *rect = DsomRegion { left, top, right - left, bottom - top };
+  return true;
+}
+
+#endif /* __GST_DSOM_REGION_H__ */